@@ -18,11 +18,8 @@ void fitSpectraToPowerLaws(float32_t *vData,
                            uint16_t   numFreqencies, 
                            uint8_t    numOverlap)
 {
-	//float32_t mNumerator = mNumeratorCalculate(&xSeg[0],&vData[0],numSeg);
-											/*Calculates the numerator part of the fit equation*/
-  float32_t m = mNumeratorCalculate(&xSeg[0],&vData[0],numSeg)/mDenominator;		/*Calculates the ratio*/
-  float32_t b = ((calculate_sum_of_array_f32(&vData[0],numSeg))/numSeg)-(0.5*m);        	
-											/*calculates b in y = mx +b equation*/
+  float32_t m, b;
+  calculateLineOfBestFitCoefs(&vData[0], &xSeg[0], numSeg, mDenominator, &m, &b);	/*calculates m and b in y = mx +b equation*/
   float32_t windowedY[numFreqencies],
 	    testInput[numFreqencies], 
 	    testConj[numSeg],
@@ -189,12 +186,47 @@ Adaptation of existing arm CMSIS code for calculating sum of elements in an arra
     /* Decrement the loop counter */
     blkCnt--;
   }
+
+  /* If the blockSize is not a multiple of 4, compute any remaining samples here.
+   ** No loop unrolling is used. */
+  blkCnt = blockSize % 0x4u;
+
+  while(blkCnt > 0u)
+  {
+    /* C = (A[0] + A[1] + A[2] + ... + A[blockSize-1]) */
+    sum += *pSrc++;
+
+    /* Decrement the loop counter */
+    blkCnt--;
+  }
   return(sum);
 }
 
 
 /*****************************************************************************************/
-void calculateLineOfBestFit(float32_t 	*pSrcA, 
+void calculateLineOfBestFitCoefs(float32_t	*pSrcA,
+                                 float32_t 	*pSrcB,
+                                 uint16_t 	blockSize,
+                                 float32_t 	mDenominator,
+                                 float32_t 	*m,
+                                 float32_t 	*b)
+{
+     /*
+ * @brief Calculates slope and intercept of y = m x + b using least squares
+ * @param[in]       *pSrcA points to the input vector      y
+ * @param[in]       *pSrcB points to the input vector      x (-N_seg/2+1 : N_seg/2)
+ * @param[in]       blockSize number of samples in each vector
+ * @param[in]       mDenominator output of mDenominatorCalculate
+ * @param[out]      *m = m_numerator/m_denominator
+ * @param[out]      *b = sum(y)/N_seg - m/2
+ * @return          None
+ */
+  *m = mNumeratorCalculate(&pSrcB[0],&pSrcA[0],blockSize)/mDenominator;		/*Calculates the ratio*/
+  *b = ((calculate_sum_of_array_f32(&pSrcA[0],blockSize))/blockSize)-(0.5*(*m));	/*calculates b in y = mx +b equation*/
+}
+
+/*****************************************************************************************/
+void calculateLineOfBestFit(float32_t 	*pSrcA,
                             float32_t 	*pSrcB, 
                             uint16_t 	blockSize,
                             float32_t 	m,
@@ -97,7 +97,14 @@ float32_t mNumeratorCalculate(float32_t		*pSrcA,
 float32_t calculate_sum_of_array_f32(float32_t 	*pSrc,
 				     uint32_t 	blockSize);
 
-void calculateLineOfBestFit(float32_t	*pSrcA, 
+void calculateLineOfBestFitCoefs(float32_t	*pSrcA,
+                                 float32_t 	*pSrcB,
+                                 uint16_t 	blockSize,
+                                 float32_t 	mDenominator,
+                                 float32_t 	*m,
+                                 float32_t 	*b);
+
+void calculateLineOfBestFit(float32_t	*pSrcA,
                             float32_t 	*pSrcB, 
                             uint16_t 	blockSize,
                             float32_t 	m,
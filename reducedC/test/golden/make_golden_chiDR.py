@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Write chiDR_golden.txt, the reference blocks used by ../test_chiDR.c
+
+Line-for-line transcription of make_golden_chiDR_fcs.m for machines without
+MATLAB or Octave. Uses only the Python standard library and computes the
+reference in double precision from float32-rounded inputs, following
+
+    other/despike_shear_blocks_fcs.m       (despike_segment)
+    reduced/fit_spectra_to_power_laws_fcs.m (detrend, pwelch, power-law fits)
+    reduced/define_freq_fit_ranges_fcs.m    (f, fbounds)
+
+Prefer the MATLAB script when it is available; the two write the same format
+and record their own name on the 'generator' line.
+
+Usage: python3 make_golden_chiDR.py > chiDR_golden.txt
+"""
+
+import math
+import struct
+import sys
+
+FS = 100
+NSEG = 512
+NFFT = 256
+NOVERLAP = 128
+NBLOCKS = 3
+CHANNELS = ['S1', 'S2', 'T1P', 'T2P']
+
+
+def single(x):
+    """Round a double to the nearest float32, as MATLAB double(single(x))"""
+    return struct.unpack('f', struct.pack('f', x))[0]
+
+
+def minstd(seed, n):
+    """Park-Miller minimal standard generator; exact in double precision"""
+    u = []
+    for _ in range(n):
+        seed = (16807*seed) % 2147483647
+        u.append(seed/2147483647)
+    return u
+
+
+def synthetic_block(bi, ci):
+    """Trend + three sinusoids + uniform noise (+ spikes on shear channels)"""
+    u = minstd(1 + 100*bi + ci, NSEG)
+    freqs = [1.7 + 0.3*bi, 3.9 + 0.2*ci, 12.5]
+    amps = [0.4, 0.2, 0.05]
+    y = []
+    for n in range(NSEG):
+        t = n/FS
+        v = 0.1*(ci + 1) + 0.2*(bi + 1)*(-1)**ci*n/(NSEG - 1)
+        for k in range(3):
+            v += amps[k]*math.sin(2*math.pi*freqs[k]*t + 0.3*(k + 1) + 0.1*ci)
+        v += 0.1*(u[n] - 0.5)
+        y.append(v)
+    if CHANNELS[ci].startswith('S'):
+        for si, idx in enumerate([37 + 50*bi, 201, 450 - 10*ci]):
+            y[idx] += 6*(-1)**si
+    return [single(v) for v in y]
+
+
+def mean(x):
+    return sum(x)/len(x)
+
+
+def std(x):
+    xm = mean(x)
+    return math.sqrt(sum((v - xm)**2 for v in x)/(len(x) - 1))
+
+
+def despike_segment(x):
+    xm = mean(x)
+    thresh = 3*std(x)
+    spikes = [abs(v - xm) > thresh for v in x]
+    margin = min(abs(abs(v - xm) - thresh) for v in x)
+    good = mean([v for v, s in zip(x, spikes) if not s])
+    return [good if s else v for v, s in zip(x, spikes)], margin
+
+
+def linear_fit(y):
+    """polyfit(x, y, 1) with x = (-Nseg/2+1):(Nseg/2), as used by detrend"""
+    x = list(range(-NSEG//2 + 1, NSEG//2 + 1))
+    xm, ym = mean(x), mean(y)
+    m = sum((a - xm)*(b - ym) for a, b in zip(x, y))/sum((a - xm)**2 for a in x)
+    b = ym - m*xm
+    return m, b, [v - (m*a + b) for a, v in zip(x, y)]
+
+
+def pwelch(v):
+    """pwelch(v, Nfft, Noverlap, Nfft, fs): symmetric Hamming, one-sided PSD"""
+    w = [0.54 - 0.46*math.cos(2*math.pi*n/(NFFT - 1)) for n in range(NFFT)]
+    starts = range(0, NSEG - NFFT + 1, NFFT - NOVERLAP)
+    nf = NFFT//2 + 1
+    cos_tab = [math.cos(2*math.pi*k/NFFT) for k in range(NFFT)]
+    sin_tab = [math.sin(2*math.pi*k/NFFT) for k in range(NFFT)]
+    psd = [0.0]*nf
+    for s in starts:
+        seg = [v[s + n]*w[n] for n in range(NFFT)]
+        for k in range(nf):
+            re = sum(seg[n]*cos_tab[(k*n) % NFFT] for n in range(NFFT))
+            im = sum(seg[n]*sin_tab[(k*n) % NFFT] for n in range(NFFT))
+            psd[k] += re*re + im*im
+    scale = len(starts)*FS*sum(a*a for a in w)
+    psd = [p/scale for p in psd]
+    return [psd[0]] + [2*p for p in psd[1:-1]] + [psd[-1]]
+
+
+def freq_fit_ranges():
+    nf = NFFT//2 + 1
+    f = [FS/2*i/(nf - 1) for i in range(nf)]
+    fbounds = []
+    for bound in [1, 3, 3, 5]:
+        idx = max(i for i in range(nf) if f[i] < bound)
+        fbounds.append((f[idx] + f[idx + 1])/2)
+    return f, fbounds
+
+
+def power_law_fits(psd, f, fbounds, power):
+    fits = []
+    for lo, hi in [fbounds[0:2], fbounds[2:4]]:
+        idx = [i for i in range(len(f)) if lo <= f[i] <= hi]
+        fits.append(sum(psd[i]*f[i]**(power/2) for i in idx)/sum(f[i]**power for i in idx))
+    return fits
+
+
+def fmt(values):
+    return ' '.join('%.9g' % v for v in values)
+
+
+def main(out):
+    f, fbounds = freq_fit_ranges()
+    out.write('% chiDR golden vectors. Generated by make_golden_chiDR.py '
+              '(Python transcription, not MATLAB); do not edit by hand.\n')
+    out.write('generator make_golden_chiDR.py\n')
+    out.write('fs %d\nnseg %d\nnfft %d\nnoverlap %d\n' % (FS, NSEG, NFFT, NOVERLAP))
+    out.write('f %d %s\n' % (len(f), fmt(f)))
+    out.write('fbounds 4 %s\n' % fmt(fbounds))
+    out.write('nblocks %d\n' % NBLOCKS)
+    for bi in range(NBLOCKS):
+        out.write('block %d\n' % (bi + 1))
+        for ci, name in enumerate(CHANNELS):
+            y = synthetic_block(bi, ci)
+            out.write('chan %s\n' % name)
+            out.write('input %d %s\n' % (NSEG, fmt(y)))
+            if name.startswith('S'):
+                y, margin = despike_segment(y)
+                if margin < 1e-3:
+                    sys.exit('block %d %s has a sample within %g of the 3*std '
+                             'threshold' % (bi + 1, name, margin))
+                out.write('despiked %d %s\n' % (NSEG, fmt(y)))
+                power = 2/3
+            else:
+                power = 2
+            m, b, v = linear_fit(y)
+            psd = pwelch(v)
+            out.write('m %s\nb %s\n' % (fmt([m]), fmt([b])))
+            out.write('psd %d %s\n' % (len(psd), fmt(psd)))
+            out.write('vpsi 2 %s\n' % fmt(power_law_fits(psd, f, fbounds, power)))
+    out.write('end\n')
+
+
+if __name__ == '__main__':
+    main(sys.stdout)
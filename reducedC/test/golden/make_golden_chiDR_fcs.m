@@ -0,0 +1,112 @@
+function make_golden_chiDR_fcs(out_filename)
+% function make_golden_chiDR_fcs(out_filename)
+%   Write the reference blocks and expected outputs used by reducedC/test/test_chiDR.c
+%
+%   Synthetic blocks (trend + sinusoids + noise, plus spikes on the shear channels) are
+%   rounded to single precision, as on the Teensy, and then passed through the
+%   same functions as process_cast_reduced_fcs:
+%       despike_shear_blocks_fcs
+%       fit_spectra_to_power_laws_fcs
+%   The detrend coefficients (m, b) and the Welch spectra are also written since the
+%   C code exposes them as intermediate steps.
+%
+%   make_golden_chiDR.py in this directory is a standard-library Python transcription
+%   of this script for machines without MATLAB or Octave. Both write the same format and
+%   record their own name on the 'generator' line.
+%
+%   Input
+%   -----
+%   out_filename: defaults to chiDR_golden.txt next to this script
+%
+%   Example (MATLAB or Octave, from reducedC/test/golden)
+%   -------
+%   make_golden_chiDR_fcs()
+
+    this_dir = fileparts(mfilename('fullpath'));
+    addpath(fullfile(this_dir, '..', '..', '..', 'reduced'));
+    addpath(fullfile(this_dir, '..', '..', '..', 'other'));
+    if nargin < 1
+        out_filename = fullfile(this_dir, 'chiDR_golden.txt');
+    end
+
+    [fs, Nseg, Nfft, Noverlap, Nz] = deal(100, 512, 256, 128, 3);
+    channels = {'S1', 'S2', 'T1P', 'T2P'};
+    [f, fbounds] = define_freq_fit_ranges_fcs(fs, Nfft);
+
+    % Nz x Nseg blocks, as output by reshape_to_Nseg_blocks_fcs
+    blk.time = zeros(Nz, Nseg);
+    for zi = 1:Nz
+        for ci = 1:4
+            blk.(channels{ci})(zi, :) = synthetic_block(zi-1, ci-1);
+        end
+    end
+    raw = blk;
+
+    blk = despike_shear_blocks_fcs(blk);
+    Vpsi = fit_spectra_to_power_laws_fcs(blk, f, fbounds, fs, Nseg, Nfft, Noverlap);
+
+    if exist('OCTAVE_VERSION', 'builtin')
+        product = 'Octave';
+    else
+        product = 'MATLAB';
+    end
+    fid = fopen(out_filename, 'w');
+    fprintf(fid, ['%% chiDR golden vectors. Generated by make_golden_chiDR_fcs.m ', ...
+                  '(%s %s); do not edit by hand.\n'], product, version);
+    fprintf(fid, 'generator make_golden_chiDR_fcs.m\n');
+    fprintf(fid, 'fs %d\nnseg %d\nnfft %d\nnoverlap %d\n', fs, Nseg, Nfft, Noverlap);
+    write_vector('f', f);
+    write_vector('fbounds', fbounds);
+    fprintf(fid, 'nblocks %d\n', Nz);
+    for zi = 1:Nz
+        fprintf(fid, 'block %d\n', zi);
+        for ci = 1:4
+            name = channels{ci};
+            fprintf(fid, 'chan %s\n', name);
+            write_vector('input', raw.(name)(zi, :));
+            y = blk.(name)(zi, :);
+            if name(1) == 'S'
+                write_vector('despiked', y);
+            end
+            x = (-Nseg/2+1):(Nseg/2);
+            p = polyfit(x, y, 1);
+            fprintf(fid, 'm %.9g\nb %.9g\n', p(1), p(2));
+            psd = pwelch(detrend(y), Nfft, Noverlap, Nfft, fs);
+            write_vector('psd', psd);
+            write_vector('vpsi', Vpsi.(['psi_' name '_fit'])(zi, :));
+        end
+    end
+    fprintf(fid, 'end\n');
+    fclose(fid);
+
+function write_vector(key, values)
+    fprintf(fid, '%s %d', key, numel(values));
+    fprintf(fid, ' %.9g', values);
+    fprintf(fid, '\n');
+end
+
+function y = synthetic_block(bi, ci)
+    % Park-Miller minimal standard generator; exact in double precision and
+    % reproducible across MATLAB, Octave and make_golden_chiDR.py
+    seed = 1 + 100*bi + ci;
+    u = zeros(1, Nseg);
+    for n = 1:Nseg
+        seed = mod(16807*seed, 2147483647);
+        u(n) = seed/2147483647;
+    end
+    t = (0:Nseg-1)/fs;
+    freqs = [1.7 + 0.3*bi, 3.9 + 0.2*ci, 12.5];
+    amps = [0.4, 0.2, 0.05];
+    y = 0.1*(ci + 1) + 0.2*(bi + 1)*(-1)^ci*(0:Nseg-1)/(Nseg - 1);
+    for k = 1:3
+        y = y + amps(k)*sin(2*pi*freqs(k)*t + 0.3*k + 0.1*ci);
+    end
+    y = y + 0.1*(u - 0.5);
+    if channels{ci+1}(1) == 'S'
+        spike_inds = [37 + 50*bi, 201, 450 - 10*ci] + 1;
+        y(spike_inds) = y(spike_inds) + 6*[1, -1, 1];
+    end
+    y = double(single(y));
+end
+
+end
@@ -0,0 +1,12 @@
+/*Host-side stand-in for the Arduino core header so that chiDR.c can be compiled
+ * and tested on a desktop machine. Only what chiDR.c uses is provided.
+ */
+
+#ifndef Arduino_h
+#define Arduino_h
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <math.h>
+
+#endif
@@ -0,0 +1,8 @@
+/*Host-side stand-in for CMSIS-DSP arm_const_structs.h (see arm_math.h in this directory)*/
+
+#ifndef arm_const_structs_h
+#define arm_const_structs_h
+
+#include "arm_math.h"
+
+#endif
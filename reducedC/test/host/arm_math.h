@@ -0,0 +1,67 @@
+/*Host-side stand-in for CMSIS-DSP arm_math.h
+ * Declares only the arm_* routines used by chiDR.c. Implementations are plain C
+ * reference versions in arm_math_host.c that follow the CMSIS-DSP documented
+ * semantics (including the packed output layout of arm_rfft_fast_f32), so results
+ * match the Teensy build to within float32 rounding. They are NOT the optimised
+ * CMSIS kernels, so host throughput numbers are only comparable with each other.
+ * More info on the semantics here:
+ * https://www.keil.com/pack/doc/CMSIS/DSP/html/index.html
+ */
+
+#ifndef arm_math_h
+#define arm_math_h
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef float float32_t;
+
+#ifndef PI
+#define PI 3.14159265358979f
+#endif
+
+typedef enum
+{
+  ARM_MATH_SUCCESS        =  0,
+  ARM_MATH_ARGUMENT_ERROR = -1
+} arm_status;
+
+typedef struct
+{
+  uint16_t fftLenRFFT;        /* length of the real sequence */
+} arm_rfft_fast_instance_f32;
+
+float32_t arm_cos_f32(float32_t x);
+
+void arm_fill_f32(float32_t value, float32_t *pDst, uint32_t blockSize);
+
+void arm_copy_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize);
+
+void arm_add_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize);
+
+void arm_mult_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize);
+
+void arm_dot_prod_f32(const float32_t *pSrcA, const float32_t *pSrcB, uint32_t blockSize, float32_t *result);
+
+void arm_mean_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult);
+
+void arm_var_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult);
+
+void arm_cmplx_conj_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples);
+
+void arm_cmplx_mult_cmplx_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t numSamples);
+
+void arm_cmplx_mag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples);
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen);
+
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif
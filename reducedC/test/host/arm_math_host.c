@@ -0,0 +1,234 @@
+#include "arm_math.h"
+#include <math.h>
+
+#define HOST_PI_F64 3.14159265358979323846
+
+/*Plain C versions of the CMSIS-DSP routines used by chiDR.c. See arm_math.h in this directory.*/
+
+/*****************************************************************************************/
+
+float32_t arm_cos_f32(float32_t x)
+{
+  return(cosf(x));
+}
+
+/*****************************************************************************************/
+
+void arm_fill_f32(float32_t value, float32_t *pDst, uint32_t blockSize)
+{
+  uint32_t blkCnt = 0;
+  while(blkCnt < blockSize)
+  {
+    *(pDst+blkCnt) = value;
+    blkCnt++;
+  }
+}
+
+/*****************************************************************************************/
+
+void arm_copy_f32(const float32_t *pSrc, float32_t *pDst, uint32_t blockSize)
+{
+  uint32_t blkCnt = 0;
+  while(blkCnt < blockSize)
+  {
+    *(pDst+blkCnt) = *(pSrc+blkCnt);
+    blkCnt++;
+  }
+}
+
+/*****************************************************************************************/
+
+void arm_add_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize)
+{
+  uint32_t blkCnt = 0;
+  while(blkCnt < blockSize)
+  {
+    *(pDst+blkCnt) = *(pSrcA+blkCnt) + *(pSrcB+blkCnt);
+    blkCnt++;
+  }
+}
+
+/*****************************************************************************************/
+
+void arm_mult_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t blockSize)
+{
+  uint32_t blkCnt = 0;
+  while(blkCnt < blockSize)
+  {
+    *(pDst+blkCnt) = *(pSrcA+blkCnt) * *(pSrcB+blkCnt);
+    blkCnt++;
+  }
+}
+
+/*****************************************************************************************/
+
+void arm_dot_prod_f32(const float32_t *pSrcA, const float32_t *pSrcB, uint32_t blockSize, float32_t *result)
+{
+  float32_t sum = 0.0f;
+  uint32_t blkCnt = 0;
+  while(blkCnt < blockSize)
+  {
+    sum += *(pSrcA+blkCnt) * *(pSrcB+blkCnt);
+    blkCnt++;
+  }
+  *result = sum;
+}
+
+/*****************************************************************************************/
+
+void arm_mean_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult)
+{
+  float32_t sum = 0.0f;
+  uint32_t blkCnt = 0;
+  while(blkCnt < blockSize)
+  {
+    sum += *(pSrc+blkCnt);
+    blkCnt++;
+  }
+  *pResult = sum/(float32_t)blockSize;
+}
+
+/*****************************************************************************************/
+
+void arm_var_f32(const float32_t *pSrc, uint32_t blockSize, float32_t *pResult)
+{
+  /*Sample variance (normalised by blockSize-1), same as MATLAB var/std*/
+  float32_t mean, diff;
+  float32_t sumOfSquares = 0.0f;
+  uint32_t blkCnt = 0;
+
+  if(blockSize <= 1u)
+  {
+    *pResult = 0.0f;
+    return;
+  }
+  arm_mean_f32(pSrc, blockSize, &mean);
+  while(blkCnt < blockSize)
+  {
+    diff = *(pSrc+blkCnt) - mean;
+    sumOfSquares += diff*diff;
+    blkCnt++;
+  }
+  *pResult = sumOfSquares/(float32_t)(blockSize - 1u);
+}
+
+/*****************************************************************************************/
+
+void arm_cmplx_conj_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples)
+{
+  uint32_t blkCnt = 0;
+  while(blkCnt < numSamples)
+  {
+    *(pDst+2*blkCnt)   =  *(pSrc+2*blkCnt);
+    *(pDst+2*blkCnt+1) = -*(pSrc+2*blkCnt+1);
+    blkCnt++;
+  }
+}
+
+/*****************************************************************************************/
+
+void arm_cmplx_mult_cmplx_f32(const float32_t *pSrcA, const float32_t *pSrcB, float32_t *pDst, uint32_t numSamples)
+{
+  float32_t a, b, c, d;
+  uint32_t blkCnt = 0;
+  while(blkCnt < numSamples)
+  {
+    a = *(pSrcA+2*blkCnt);
+    b = *(pSrcA+2*blkCnt+1);
+    c = *(pSrcB+2*blkCnt);
+    d = *(pSrcB+2*blkCnt+1);
+    *(pDst+2*blkCnt)   = a*c - b*d;
+    *(pDst+2*blkCnt+1) = a*d + b*c;
+    blkCnt++;
+  }
+}
+
+/*****************************************************************************************/
+
+void arm_cmplx_mag_f32(const float32_t *pSrc, float32_t *pDst, uint32_t numSamples)
+{
+  float32_t re, im;
+  uint32_t blkCnt = 0;
+  while(blkCnt < numSamples)
+  {
+    re = *(pSrc+2*blkCnt);
+    im = *(pSrc+2*blkCnt+1);
+    *(pDst+blkCnt) = sqrtf(re*re + im*im);
+    blkCnt++;
+  }
+}
+
+/*****************************************************************************************/
+
+arm_status arm_rfft_fast_init_f32(arm_rfft_fast_instance_f32 *S, uint16_t fftLen)
+{
+  /*CMSIS supports power-of-two lengths from 32 to 4096*/
+  if(fftLen < 32u || fftLen > 4096u || (fftLen & (fftLen - 1u)) != 0u)
+  {
+    return(ARM_MATH_ARGUMENT_ERROR);
+  }
+  S->fftLenRFFT = fftLen;
+  return(ARM_MATH_SUCCESS);
+}
+
+/*****************************************************************************************/
+
+void arm_rfft_fast_f32(const arm_rfft_fast_instance_f32 *S, float32_t *p, float32_t *pOut, uint8_t ifftFlag)
+{
+  /*
+ * @brief Forward real FFT with the CMSIS packed output layout:
+ *        pOut[0] = Re X[0], pOut[1] = Re X[N/2], pOut[2k], pOut[2k+1] = Re, Im X[k] for k = 1 .. N/2-1
+ *        Computed with an in-place radix-2 complex FFT of length N. Only the forward
+ *        transform is provided since chiDR.c does not use the inverse.
+ */
+  uint16_t N = S->fftLenRFFT;
+  float32_t re[N], im[N];
+  float32_t tRe, tIm, wRe, wIm, uRe, uIm;
+  uint16_t ii, jj, bit, len, half, kk;
+
+  if(ifftFlag != 0u || N == 0u)
+  {
+    arm_fill_f32(0, &pOut[0], N);
+    return;
+  }
+
+  for(ii = 0; ii < N; ii++)                                      /*bit-reversed copy of the input*/
+  {
+    jj = 0;
+    for(bit = 1; bit < N; bit <<= 1)
+    {
+      jj = (jj << 1) | ((ii & bit) ? 1u : 0u);
+    }
+    re[jj] = p[ii];
+    im[jj] = 0.0f;
+  }
+
+  for(len = 2; len <= N; len <<= 1)                              /*butterflies*/
+  {
+    half = len >> 1;
+    for(kk = 0; kk < half; kk++)
+    {
+      wRe = (float32_t)cos(-2.0*HOST_PI_F64*kk/len);
+      wIm = (float32_t)sin(-2.0*HOST_PI_F64*kk/len);
+      for(ii = kk; ii < N; ii += len)
+      {
+        uRe = re[ii];
+        uIm = im[ii];
+        tRe = wRe*re[ii+half] - wIm*im[ii+half];
+        tIm = wRe*im[ii+half] + wIm*re[ii+half];
+        re[ii]      = uRe + tRe;
+        im[ii]      = uIm + tIm;
+        re[ii+half] = uRe - tRe;
+        im[ii+half] = uIm - tIm;
+      }
+    }
+  }
+
+  pOut[0] = re[0];
+  pOut[1] = re[N/2];
+  for(kk = 1; kk < N/2; kk++)
+  {
+    pOut[2*kk]   = re[kk];
+    pOut[2*kk+1] = im[kk];
+  }
+}
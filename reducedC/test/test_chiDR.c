@@ -0,0 +1,555 @@
+/*Host test runner for chiDR.c
+ * 1. Checks calculate_sum_of_array_f32, mNumeratorCalculate and calculateLineOfBestFitCoefs
+ *    for block sizes that are and are not multiples of 4, and the despikeShearSegment threshold
+ * 2. Runs the on-board chain (despike, detrend, Welch PSD, fit masks, power-law fits) on the reference
+ *    blocks in golden/chiDR_golden.txt and compares with the reference outputs within the
+ *    tolerances defined below. The "generator" line of the file names the script that wrote it
+ * 3. With --bench, times each kernel and prints blocks/s (one block = one Nseg segment)
+ *
+ * Usage: test_chiDR [--bench] [golden/chiDR_golden.txt]
+ * See README.md in this directory.
+ */
+
+#include <chiDR.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#define MAX_NSEG	1024
+#define MAX_NFREQ	(MAX_NSEG/2 + 1)
+#define NUM_CHAN	4
+
+/*Tolerances: |chiDR - reference| <= RTOL*|reference| + ATOL. chiDR is float32, the reference is double*/
+#define SUM_RTOL	1e-6					/*calculate_sum_of_array_f32 vs double sum*/
+#define MNUM_RTOL	1e-5					/*mNumeratorCalculate vs double*/
+#define DESPIKE_RTOL	1e-6					/*despiked samples*/
+#define DESPIKE_ATOL	1e-6
+#define F_ATOL		1e-5					/*frequency vector, Hz*/
+#define M_RTOL		1e-4					/*detrend slope*/
+#define B_RTOL		1e-5					/*detrend intercept*/
+#define PSD_RTOL	1e-4					/*Welch PSD per bin ...*/
+#define PSD_ATOL_REL	1e-5					/* ... plus this fraction of the largest bin*/
+#define VPSI_RTOL	1e-4					/*power-law fits*/
+
+/*Integer fit-range bounds passed to fidxCompute by the firmware (approx_bounds in
+  define_freq_fit_ranges_fcs); for fs = 100 Hz and Nfft = 256 they select the same bins as fbounds*/
+static const uint16_t fidxBounds[4] = {1, 3, 3, 5};
+
+#define BENCH_SECONDS	0.25					/*minimum run time per kernel*/
+
+typedef struct
+{
+  char		name[8];
+  bool		isShear;
+  float32_t	input[MAX_NSEG];
+  float32_t	despiked[MAX_NSEG];
+  double	m;
+  double	b;
+  double	psd[MAX_NFREQ];
+  double	vpsi[2];
+} goldenChan;
+
+typedef struct
+{
+  char		generator[64];					/*script that wrote the golden file*/
+  uint16_t	fs;
+  uint16_t	nseg;
+  uint16_t	nfft;
+  uint16_t	noverlap;
+  uint16_t	nfreq;
+  double	f[MAX_NFREQ];
+  double	fbounds[4];
+  uint16_t	nblocks;
+  goldenChan	*chan;						/*nblocks*NUM_CHAN, S1 S2 T1P T2P per block*/
+} goldenData;
+
+typedef struct
+{
+  float32_t	hammWind[MAX_NSEG];
+  float32_t	xSeg[MAX_NSEG];
+  float32_t	f[MAX_NFREQ];
+  bool		fidx[2][MAX_NFREQ];
+  float32_t	normFactor;
+  float32_t	mDenominator;
+} chiDRSetup;
+
+static int numChecks = 0;
+static int numFailures = 0;
+
+/*****************************************************************************************/
+
+static double checkClose(const char *what, double got, double want, double rtol, double atol)
+{
+  /*
+ * @brief Counts a failure (and prints it) when got is outside rtol*|want| + atol
+ * @return relative error |got - want|/|want| (absolute error if want == 0)
+ */
+  double err = fabs(got - want);
+  numChecks++;
+  if (!(err <= rtol*fabs(want) + atol))
+  {
+    numFailures++;
+    printf("FAIL %s: got %.9g, want %.9g (err %.3g)\n", what, got, want, err);
+  }
+  return (want != 0) ? err/fabs(want) : err;
+}
+
+/*****************************************************************************************/
+
+static void testSumRemainder(void)
+{
+  /*
+ * Block sizes 4k .. 4k+3 for small and Nseg-sized blocks. The tail samples are the largest,
+ * so dropping the blockSize % 4 remainder changes the sums by far more than the tolerance.
+ */
+  const uint16_t sizes[] = {4, 5, 6, 7, 512, 513, 514, 515};
+  float32_t y[MAX_NSEG], x[MAX_NSEG];
+  char what[64];
+
+  for (uint8_t ii = 0; ii < sizeof(sizes)/sizeof(sizes[0]); ii++)
+  {
+    uint16_t N = sizes[ii];
+    double sumY = 0, sumXY = 0;
+
+    generateEvenSpacedNum(-(int16_t)(N/2) + 1, N, &x[0]);
+    for (uint16_t n = 0; n < N; n++)
+    {
+      y[n] = 0.25f*n + sinf(n);
+      sumY  += y[n];
+      sumXY += (double)x[n]*y[n];
+    }
+
+    snprintf(what, sizeof(what), "calculate_sum_of_array_f32 N=%u", N);
+    checkClose(what, calculate_sum_of_array_f32(&y[0], N), sumY, SUM_RTOL, 0);
+
+    snprintf(what, sizeof(what), "mNumeratorCalculate N=%u", N);
+    checkClose(what, mNumeratorCalculate(&x[0], &y[0], N), 2*sumXY - sumY, MNUM_RTOL, 0);
+
+    /*b = sum(y)/N_seg - m/2 as in fitSpectraToPowerLaws*/
+    float32_t m, b;
+    double mDenom = N*((double)N*N - 1)/6;
+    double mWant  = (2*sumXY - sumY)/mDenom;
+    calculateLineOfBestFitCoefs(&y[0], &x[0], N, mDenominatorCalculate(N), &m, &b);
+    snprintf(what, sizeof(what), "calculateLineOfBestFitCoefs m N=%u", N);
+    checkClose(what, m, mWant, MNUM_RTOL, 0);
+    snprintf(what, sizeof(what), "calculateLineOfBestFitCoefs b N=%u", N);
+    checkClose(what, b, sumY/N - mWant/2, MNUM_RTOL, 0);
+  }
+}
+
+/*****************************************************************************************/
+
+static void testDespikeThreshold(void)
+{
+  /*
+ * Alternating +-1 with one sample just inside and one just outside 3 standard deviations,
+ * compared with despike_segment from other/despike_shear_blocks_fcs.m evaluated in double:
+ *   spikes = abs(X - mean(X)) > 3*std(X);  X(spikes) = mean(X(~spikes));
+ */
+  const uint16_t N = 512;
+  float32_t x[MAX_NSEG];
+  bool spikes[MAX_NSEG];
+  double xMean = 0, xVar = 0, goodSum = 0;
+  uint16_t goodCnt = 0;
+  char what[64];
+
+  for (uint16_t n = 0; n < N; n++)
+    x[n] = (n % 2) ? -1.0f : 1.0f;
+  x[100] = 2.9f;						/*~2.8 std from the mean: kept*/
+  x[201] = 3.6f;						/*~3.5 std from the mean: replaced*/
+
+  for (uint16_t n = 0; n < N; n++)
+    xMean += x[n]/(double)N;
+  for (uint16_t n = 0; n < N; n++)
+    xVar += (x[n] - xMean)*(x[n] - xMean)/(N - 1);
+  for (uint16_t n = 0; n < N; n++)
+  {
+    spikes[n] = fabs(x[n] - xMean) > 3*sqrt(xVar);
+    if (!spikes[n])
+    {
+      goodSum += x[n];
+      goodCnt++;
+    }
+  }
+
+  float32_t y[MAX_NSEG];
+  memcpy(y, x, N*sizeof(float32_t));
+  despikeShearSegment(&y[0], N);
+  for (uint16_t n = 0; n < N; n++)
+  {
+    snprintf(what, sizeof(what), "despikeShearSegment threshold x[%u]", n);
+    checkClose(what, y[n], spikes[n] ? goodSum/goodCnt : x[n], DESPIKE_RTOL, DESPIKE_ATOL);
+  }
+}
+
+/*****************************************************************************************/
+
+static bool readValues(FILE *fp, const char *key, uint16_t maxCnt, uint16_t *cnt, double *pDst)
+{
+  /*Reads "<count> v1 v2 ..." that follows key in the golden file*/
+  unsigned int n;
+  if (fscanf(fp, "%u", &n) != 1 || n > maxCnt)
+  {
+    fprintf(stderr, "golden file: bad count for %s\n", key);
+    return false;
+  }
+  for (unsigned int ii = 0; ii < n; ii++)
+  {
+    if (fscanf(fp, "%lf", &pDst[ii]) != 1)
+    {
+      fprintf(stderr, "golden file: short vector for %s\n", key);
+      return false;
+    }
+  }
+  if (cnt != NULL)
+  {
+    *cnt = (uint16_t)n;
+  }
+  return true;
+}
+
+/*****************************************************************************************/
+
+static bool readGolden(const char *fileName, goldenData *g)
+{
+  FILE *fp = fopen(fileName, "r");
+  char key[32];
+  double buf[MAX_NSEG];
+  uint16_t cnt;
+  int chanIdx = -1;
+  unsigned int val;
+
+  if (fp == NULL)
+  {
+    fprintf(stderr, "cannot open %s\n", fileName);
+    return false;
+  }
+  memset(g, 0, sizeof(*g));
+
+  while (fscanf(fp, "%31s", key) == 1)
+  {
+    goldenChan *c = (chanIdx >= 0) ? &g->chan[chanIdx] : NULL;
+
+    if (key[0] == '%')
+    {
+      while (fgetc(fp) != '\n' && !feof(fp));
+    }
+    else if (strcmp(key, "end") == 0)
+    {
+      break;
+    }
+    else if (strcmp(key, "generator") == 0)
+    {
+      if (fscanf(fp, "%63s", g->generator) != 1)
+        goto bad;
+    }
+    else if (strcmp(key, "fs") == 0 || strcmp(key, "nseg") == 0 || strcmp(key, "nfft") == 0
+          || strcmp(key, "noverlap") == 0 || strcmp(key, "nblocks") == 0 || strcmp(key, "block") == 0)
+    {
+      if (fscanf(fp, "%u", &val) != 1)
+        goto bad;
+      if (strcmp(key, "fs") == 0)
+        g->fs = val;
+      else if (strcmp(key, "nseg") == 0)
+        g->nseg = val;
+      else if (strcmp(key, "nfft") == 0)
+        g->nfft = val;
+      else if (strcmp(key, "noverlap") == 0)
+        g->noverlap = val;					/*"block <n>" numbers are informational*/
+      else if (strcmp(key, "nblocks") == 0)
+      {
+        g->nblocks = val;
+        g->chan = calloc((size_t)val*NUM_CHAN, sizeof(goldenChan));
+      }
+      if (g->nseg > MAX_NSEG)
+        goto bad;
+    }
+    else if (strcmp(key, "f") == 0)
+    {
+      if (!readValues(fp, key, MAX_NFREQ, &g->nfreq, &g->f[0]))
+        goto bad;
+    }
+    else if (strcmp(key, "fbounds") == 0)
+    {
+      if (!readValues(fp, key, 4, NULL, &g->fbounds[0]))
+        goto bad;
+    }
+    else if (strcmp(key, "chan") == 0)
+    {
+      if (g->chan == NULL || ++chanIdx >= g->nblocks*NUM_CHAN)
+        goto bad;
+      c = &g->chan[chanIdx];
+      if (fscanf(fp, "%7s", c->name) != 1)
+        goto bad;
+      c->isShear = (c->name[0] == 'S');
+    }
+    else if (c != NULL && (strcmp(key, "input") == 0 || strcmp(key, "despiked") == 0))
+    {
+      if (!readValues(fp, key, MAX_NSEG, &cnt, &buf[0]) || cnt != g->nseg)
+        goto bad;
+      float32_t *pDst = (key[0] == 'i') ? &c->input[0] : &c->despiked[0];
+      for (uint16_t ii = 0; ii < cnt; ii++)
+        pDst[ii] = (float32_t)buf[ii];
+    }
+    else if (c != NULL && strcmp(key, "m") == 0)
+    {
+      if (fscanf(fp, "%lf", &c->m) != 1)
+        goto bad;
+    }
+    else if (c != NULL && strcmp(key, "b") == 0)
+    {
+      if (fscanf(fp, "%lf", &c->b) != 1)
+        goto bad;
+    }
+    else if (c != NULL && strcmp(key, "psd") == 0)
+    {
+      if (!readValues(fp, key, MAX_NFREQ, &cnt, &c->psd[0]) || cnt != g->nfreq)
+        goto bad;
+    }
+    else if (c != NULL && strcmp(key, "vpsi") == 0)
+    {
+      if (!readValues(fp, key, 2, NULL, &c->vpsi[0]))
+        goto bad;
+    }
+    else
+    {
+      goto bad;
+    }
+  }
+  fclose(fp);
+  if (chanIdx + 1 != g->nblocks*NUM_CHAN || g->nfreq != g->nfft/2 + 1 || g->generator[0] == '\0')
+  {
+    fprintf(stderr, "golden file: incomplete\n");
+    return false;
+  }
+  return true;
+
+bad:
+  fprintf(stderr, "golden file: cannot parse near '%s'\n", key);
+  fclose(fp);
+  return false;
+}
+
+/*****************************************************************************************/
+
+static void setupChiDR(const goldenData *g, chiDRSetup *s)
+{
+  /*Same one-time setup as the firmware*/
+  generateHammingWindow(&s->hammWind[0], g->nfft);
+  s->normFactor = calculateNormFactorWindow(&s->hammWind[0], g->nfft);
+  generateEvenSpacedNum(-(int16_t)(g->nseg/2) + 1, g->nseg, &s->xSeg[0]);
+  s->mDenominator = mDenominatorCalculate(g->nseg);
+  defineFreqFiltRanges(g->fs, g->nfft, &s->f[0]);
+
+  fidxCompute(&s->f[0], &s->fidx[0][0], fidxBounds[0], fidxBounds[1], g->nfreq);
+  fidxCompute(&s->f[0], &s->fidx[1][0], fidxBounds[2], fidxBounds[3], g->nfreq);
+}
+
+/*****************************************************************************************/
+
+static void runChannel(const goldenData *g, const chiDRSetup *s, const goldenChan *c,
+                       float32_t *vData, float32_t *m, float32_t *b, float32_t *psdSum, float32_t *vpsi)
+{
+  /*On-board chain for one Nseg segment: despike (shear only), detrend, PSD, power-law fits*/
+  memcpy(vData, c->input, g->nseg*sizeof(float32_t));
+  if (c->isShear)
+  {
+    despikeShearSegment(vData, g->nseg);
+  }
+  calculateLineOfBestFitCoefs(vData, (float32_t *)s->xSeg, g->nseg, s->mDenominator, m, b);
+  fitSpectraToPowerLaws(vData, (float32_t *)s->hammWind, (float32_t *)s->xSeg, psdSum, (float32_t *)s->f,
+                        s->normFactor, s->mDenominator, g->fs, g->nseg, g->nfft, g->noverlap);
+  for (uint8_t ii = 0; ii < 2; ii++)
+  {
+    vpsi[ii] = c->isShear ? psiShearFit(psdSum, (bool *)s->fidx[ii], (float32_t *)s->f, g->nfreq)
+                          : fitPsiTP(psdSum, (bool *)s->fidx[ii], (float32_t *)s->f, g->nfreq);
+  }
+}
+
+/*****************************************************************************************/
+
+static void testGolden(const goldenData *g, const chiDRSetup *s)
+{
+  float32_t vData[MAX_NSEG], psdSum[MAX_NFREQ], despiked[MAX_NSEG], m, b, vpsi[2];
+  double worstM = 0, worstB = 0, worstPsd = 0, worstVpsi = 0, err;
+  char what[64];
+
+  for (uint16_t ii = 0; ii < g->nfreq; ii++)
+  {
+    snprintf(what, sizeof(what), "defineFreqFiltRanges f[%u]", ii);
+    checkClose(what, s->f[ii], g->f[ii], 0, F_ATOL);
+  }
+
+  /*fidxs(:, 1) = f >= fbounds(1) & f <= fbounds(2); fidxs(:, 2) = f >= fbounds(3) & f <= fbounds(4);*/
+  for (uint8_t kk = 0; kk < 2; kk++)
+  {
+    for (uint16_t ii = 0; ii < g->nfreq; ii++)
+    {
+      bool want = g->f[ii] >= g->fbounds[2*kk] && g->f[ii] <= g->fbounds[2*kk+1];
+      snprintf(what, sizeof(what), "fidxCompute range %u f[%u]", kk + 1, ii);
+      checkClose(what, s->fidx[kk][ii], want, 0, 0);
+    }
+  }
+
+  for (uint16_t ci = 0; ci < g->nblocks*NUM_CHAN; ci++)
+  {
+    const goldenChan *c = &g->chan[ci];
+    uint16_t blk = ci/NUM_CHAN + 1;
+
+    if (c->isShear)
+    {
+      memcpy(despiked, c->input, g->nseg*sizeof(float32_t));
+      despikeShearSegment(&despiked[0], g->nseg);
+      for (uint16_t ii = 0; ii < g->nseg; ii++)
+      {
+        snprintf(what, sizeof(what), "block %u %s despiked[%u]", blk, c->name, ii);
+        checkClose(what, despiked[ii], c->despiked[ii], DESPIKE_RTOL, DESPIKE_ATOL);
+      }
+    }
+
+    runChannel(g, s, c, &vData[0], &m, &b, &psdSum[0], &vpsi[0]);
+
+    snprintf(what, sizeof(what), "block %u %s m", blk, c->name);
+    err = checkClose(what, m, c->m, M_RTOL, 0);
+    worstM = fmax(worstM, err);
+    snprintf(what, sizeof(what), "block %u %s b", blk, c->name);
+    err = checkClose(what, b, c->b, B_RTOL, 0);
+    worstB = fmax(worstB, err);
+
+    /*Bins 0 and Nfft/2 are outside both fit ranges and are not compared: chiDR adds the
+      Nyquist term of the packed rfft output into bin 0, leaves bin Nfft/2 at zero and applies
+      the one-sided factor of 2 to every bin, whereas pwelch does not double DC and Nyquist*/
+    double psdMax = 0;
+    for (uint16_t ii = 1; ii < g->nfreq - 1; ii++)
+      psdMax = fmax(psdMax, c->psd[ii]);
+    for (uint16_t ii = 1; ii < g->nfreq - 1; ii++)
+    {
+      snprintf(what, sizeof(what), "block %u %s psd[%u]", blk, c->name, ii);
+      err = checkClose(what, psdSum[ii], c->psd[ii], PSD_RTOL, PSD_ATOL_REL*psdMax);
+      if (c->psd[ii] > PSD_ATOL_REL/PSD_RTOL*psdMax)
+        worstPsd = fmax(worstPsd, err);
+    }
+
+    for (uint8_t ii = 0; ii < 2; ii++)
+    {
+      snprintf(what, sizeof(what), "block %u %s vpsi[%u]", blk, c->name, ii);
+      err = checkClose(what, vpsi[ii], c->vpsi[ii], VPSI_RTOL, 0);
+      worstVpsi = fmax(worstVpsi, err);
+    }
+  }
+
+  printf("max relative error vs reference (%s): m %.2e  b %.2e  psd %.2e  vpsi %.2e\n",
+         g->generator, worstM, worstB, worstPsd, worstVpsi);
+}
+
+/*****************************************************************************************/
+
+static double secondsNow(void)
+{
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return ts.tv_sec + 1e-9*ts.tv_nsec;
+}
+
+/*****************************************************************************************/
+
+static volatile float32_t benchSink;				/*keeps results live*/
+
+static void benchKernel(const char *kernel, const goldenData *g, const chiDRSetup *s, uint8_t which)
+{
+  /*
+ * Runs one kernel over the golden channels until BENCH_SECONDS has passed and prints blocks/s.
+ * Kernels that work in place are timed together with the copy of the input segment.
+ */
+  float32_t vData[MAX_NSEG], psdSum[MAX_NFREQ], m, b, vpsi[2];
+  uint32_t numBlocks = 0;
+  uint16_t numChan = g->nblocks*NUM_CHAN;
+  double t0, elapsed;
+
+  runChannel(g, s, &g->chan[0], &vData[0], &m, &b, &psdSum[0], &vpsi[0]);	/*valid psdSum for the fit kernels*/
+  t0 = secondsNow();
+  do
+  {
+    for (uint16_t ci = 0; ci < numChan; ci++)
+    {
+      const goldenChan *c = &g->chan[ci];
+      float32_t *y = c->isShear ? (float32_t *)c->despiked : (float32_t *)c->input;	/*input to the fit*/
+      switch (which)
+      {
+        case 0:
+          memcpy(vData, c->input, g->nseg*sizeof(float32_t));
+          despikeShearSegment(&vData[0], g->nseg);
+          benchSink = vData[0];
+          break;
+        case 1:
+          calculateLineOfBestFitCoefs(y, (float32_t *)s->xSeg, g->nseg, s->mDenominator, &m, &b);
+          benchSink = m + b;
+          break;
+        case 2:
+          memcpy(vData, y, g->nseg*sizeof(float32_t));
+          fitSpectraToPowerLaws(&vData[0], (float32_t *)s->hammWind, (float32_t *)s->xSeg, &psdSum[0], (float32_t *)s->f,
+                                s->normFactor, s->mDenominator, g->fs, g->nseg, g->nfft, g->noverlap);
+          benchSink = psdSum[1];
+          break;
+        case 3:
+          benchSink = psiShearFit(&psdSum[0], (bool *)s->fidx[0], (float32_t *)s->f, g->nfreq);
+          break;
+        case 4:
+          benchSink = fitPsiTP(&psdSum[0], (bool *)s->fidx[0], (float32_t *)s->f, g->nfreq);
+          break;
+        default:
+          runChannel(g, s, c, &vData[0], &m, &b, &psdSum[0], &vpsi[0]);
+          benchSink = vpsi[0] + vpsi[1];
+          break;
+      }
+    }
+    numBlocks += numChan;
+    elapsed = secondsNow() - t0;
+  } while (elapsed < BENCH_SECONDS);
+
+  printf("%s\t%.0f\n", kernel, numBlocks/elapsed);
+}
+
+/*****************************************************************************************/
+
+int main(int argc, char **argv)
+{
+  const char *fileName = "golden/chiDR_golden.txt";
+  bool bench = false;
+  static goldenData g;
+  static chiDRSetup s;
+
+  for (int ii = 1; ii < argc; ii++)
+  {
+    if (strcmp(argv[ii], "--bench") == 0)
+      bench = true;
+    else
+      fileName = argv[ii];
+  }
+
+  if (!readGolden(fileName, &g))
+    return 2;
+  setupChiDR(&g, &s);
+
+  if (bench)
+  {
+    /*kernel <tab> blocks/s; a block is one Nseg-sample segment of one channel*/
+    benchKernel("despikeShearSegment", &g, &s, 0);
+    benchKernel("calculateLineOfBestFitCoefs", &g, &s, 1);
+    benchKernel("fitSpectraToPowerLaws", &g, &s, 2);
+    benchKernel("psiShearFit", &g, &s, 3);
+    benchKernel("fitPsiTP", &g, &s, 4);
+    benchKernel("fullChannelChain", &g, &s, 5);
+    free(g.chan);
+    return 0;
+  }
+
+  testSumRemainder();
+  testDespikeThreshold();
+  testGolden(&g, &s);
+  free(g.chan);
+
+  printf("%d checks, %d failures\n", numChecks, numFailures);
+  return (numFailures == 0) ? 0 : 1;
+}